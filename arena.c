@@ -0,0 +1,153 @@
+/**
+* This file is part of Faces.
+* Copyright (C) 2017 Seth Simon (s.r.simon@csuohio.edu)
+* 
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "arena.h"
+#include "stats.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define SLAB_SIZE ((size_t)1 << 20)
+#define ALIGNMENT (2 * sizeof(void *))
+
+struct slab {
+    struct slab *prev;
+    size_t size;
+    char *data;
+};
+
+// The data starts right after the header, suitably aligned
+#define HEADER_SIZE \
+    ((sizeof(struct slab) + ALIGNMENT - 1) & ~(ALIGNMENT - 1))
+
+static struct slab *new_slab(size_t size) {
+    struct slab *slab = malloc(HEADER_SIZE + size);
+    if(!slab) return NULL;
+    slab->size = size;
+    slab->data = (char *)slab + HEADER_SIZE;
+    return slab;
+}
+
+static void *alloc(struct arena *arena, size_t size, size_t align) {
+    COUNT(COUNT_ARENA_BYTES, size);
+    size_t start = (arena->used + align - 1) & ~(align - 1);
+    if(!arena->slab || start + size > arena->slab->size) {
+        if(size > SLAB_SIZE / 4) {
+            // Big requests get their own slab, behind the current one
+            struct slab *slab = new_slab(size);
+            if(!slab) return NULL;
+            if(arena->slab) {
+                slab->prev = arena->slab->prev;
+                arena->slab->prev = slab;
+            } else {
+                slab->prev = NULL;
+                arena->slab = slab;
+                arena->used = size;
+            }
+            arena->nslabs++;
+            arena->bytes += size;
+            return slab->data;
+        }
+
+        struct slab *slab = new_slab(SLAB_SIZE);
+        if(!slab) return NULL;
+        slab->prev = arena->slab;
+        arena->slab = slab;
+        arena->nslabs++;
+        start = 0;
+    }
+    arena->used = start + size;
+    arena->bytes += size;
+    return arena->slab->data + start;
+}
+
+/**
+ * Returns size bytes aligned for any pointer or integer type,
+ * or NULL if malloc fails
+*/
+void *arena_alloc(struct arena *arena, size_t size) {
+    return alloc(arena, size, ALIGNMENT);
+}
+
+/**
+ * Copies the first len chars of str, which needn't be terminated,
+ * as a proper string
+*/
+char *arena_strdup(struct arena *arena, const char *str, size_t len) {
+    char *ret = alloc(arena, len + 1, 1);
+    if(ret) {
+        memcpy(ret, str, len);
+        ret[len] = '\0';
+    }
+    return ret;
+}
+
+/**
+ * Hands all of src's memory over to dst; src ends up empty
+*/
+void merge_arena(struct arena *dst, struct arena *src) {
+    if(!src->slab) return;
+    if(!dst->slab) {
+        *dst = *src;
+        *src = ARENA_DEFAULTS;
+        return;
+    }
+
+    // src's slabs go behind dst's current one
+    struct slab *last = src->slab;
+    while(last->prev) last = last->prev;
+    last->prev = dst->slab->prev;
+    dst->slab->prev = src->slab;
+
+    dst->nslabs += src->nslabs;
+    dst->bytes += src->bytes;
+    *src = ARENA_DEFAULTS;
+}
+
+/**
+ * Takes back everything handed out, but keeps the current slab for
+ * what's handed out next, unless it's one of the big ones
+*/
+void reset_arena(struct arena *arena) {
+    struct slab *keep = arena->slab;
+    if(!keep || keep->size != SLAB_SIZE) {
+        free_arena(arena);
+        return;
+    }
+
+    struct slab *slab = keep->prev;
+    while(slab) {
+        struct slab *prev = slab->prev;
+        free(slab);
+        slab = prev;
+    }
+    keep->prev = NULL;
+    arena->used = 0;
+    arena->nslabs = 1;
+    arena->bytes = 0;
+}
+
+void free_arena(struct arena *arena) {
+    struct slab *slab = arena->slab;
+    while(slab) {
+        struct slab *prev = slab->prev;
+        free(slab);
+        slab = prev;
+    }
+    *arena = ARENA_DEFAULTS;
+}
@@ -0,0 +1,48 @@
+/**
+* This file is part of Faces.
+* Copyright (C) 2017 Seth Simon (s.r.simon@csuohio.edu)
+* 
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+#define ARENA_DEFAULTS (struct arena) {\
+        .slab = NULL,\
+        .used = 0,\
+        .nslabs = 0,\
+        .bytes = 0\
+    }
+/**
+ * Hands out memory from large slabs. Nothing is freed on its own;
+ * free_arena() releases everything at once.
+*/
+struct arena {
+    struct slab *slab; // the current one, which links to the others
+    size_t used;       // bytes used in the current slab
+
+    unsigned nslabs;
+    size_t bytes; // handed out so far
+};
+
+void *arena_alloc(struct arena *arena, size_t size);
+char *arena_strdup(struct arena *arena, const char *str, size_t len);
+void merge_arena(struct arena *dst, struct arena *src);
+void reset_arena(struct arena *arena);
+void free_arena(struct arena *arena);
+
+#endif
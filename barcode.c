@@ -0,0 +1,108 @@
+/**
+* This file is part of Faces.
+* Copyright (C) 2017 Seth Simon (s.r.simon@csuohio.edu)
+* 
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "barcode.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define HEADER "Birth      Death      Dimension\n" \
+               "===============================\n"
+#define EXPORT_BUFSIZE (1 << 20)
+
+void show_barcode(struct scomplex *scomplex, int mindim, int maxdim,
+                  struct output *out) {
+    if(out->format == FORMAT_TEXT) out_puts(out, HEADER);
+    if(out->format == FORMAT_JSON) {
+        begin_json(out, "barcode");
+        out_puts(out, ",\"pairs\":[");
+    }
+
+    if(mindim < 0) mindim = 0;
+    if(maxdim >= NBETTI(scomplex)) maxdim = NBETTI(scomplex) - 1;
+    int first = 1;
+    for(int dim = mindim; dim <= maxdim; dim++) {
+        for(unsigned i = scomplex->pairs_start[dim];
+            i < scomplex->pairs_start[dim + 1]; i++) {
+            const struct pair *p = &scomplex->pairs[i];
+            const char *death = p->death == ESSENTIAL
+                                ? NULL : ID(scomplex, p->death);
+            switch(out->format) {
+            case FORMAT_TEXT:
+                out_padded(out, ID(scomplex, p->birth), 10);
+                out_char(out, ' ');
+                out_padded(out, death ? death : "inf", 10);
+                out_char(out, ' ');
+                break;
+            case FORMAT_TSV:
+                begin_row(out);
+                out_puts(out, ID(scomplex, p->birth));
+                out_char(out, '\t');
+                out_puts(out, death ? death : "inf");
+                out_char(out, '\t');
+                break;
+            case FORMAT_JSON:
+                out_puts(out, first ? "[" : ",[");
+                out_json_string(out, ID(scomplex, p->birth));
+                out_char(out, ',');
+                if(death) out_json_string(out, death);
+                else out_puts(out, "null");
+                out_char(out, ',');
+                break;
+            }
+            out_int(out, dim);
+            out_puts(out, out->format == FORMAT_JSON ? "]" : "\n");
+            first = 0;
+        }
+    }
+    if(out->format == FORMAT_JSON) out_puts(out, "]}\n");
+}
+
+/**
+ * Writes every pair as "<dimension> <birth> <death>", where birth
+ * and death are filtration indices (0 is the first simplex in the
+ * file) and the death of a class that never dies is "inf".
+ * Returns 1 if the file can't be written, after saying so to out.
+*/
+int export_barcode(struct scomplex *scomplex, const char *path,
+                   struct output *out) {
+    FILE *file = fopen(path, "w");
+    if(!file) {
+        out_error(out, "Failed to open '%s' for writing\n", path);
+        return 1;
+    }
+    setvbuf(file, NULL, _IOFBF, EXPORT_BUFSIZE);
+
+    for(int dim = 0; dim < NBETTI(scomplex); dim++) {
+        for(unsigned i = scomplex->pairs_start[dim];
+            i < scomplex->pairs_start[dim + 1]; i++) {
+            const struct pair *p = &scomplex->pairs[i];
+            if(p->death == ESSENTIAL) {
+                fprintf(file, "%d %u inf\n", dim, p->birth);
+            } else {
+                fprintf(file, "%d %u %u\n", dim, p->birth, p->death);
+            }
+        }
+    }
+
+    if(fclose(file)) {
+        out_error(out, "Failed to write '%s'\n", path);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,30 @@
+/**
+* This file is part of Faces.
+* Copyright (C) 2017 Seth Simon (s.r.simon@csuohio.edu)
+* 
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef BARCODE_H
+#define BARCODE_H
+
+#include "scomplex.h"
+#include "output.h"
+
+void show_barcode(struct scomplex *scomplex, int mindim, int maxdim,
+                  struct output *out);
+int export_barcode(struct scomplex *scomplex, const char *path,
+                   struct output *out);
+
+#endif
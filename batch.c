@@ -0,0 +1,230 @@
+/**
+* This file is part of Faces.
+* Copyright (C) 2017 Seth Simon (s.r.simon@csuohio.edu)
+* 
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+* 
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+* 
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "batch.h"
+#include "command.h"
+#include "components.h"
+#include "parallel.h"
+#include "stats.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Queries in a row are run this many at a time
+#define BLOCK 65536
+// Each thread gets at least this many of them
+#define MIN_SHARE 256
+
+/**
+ * Queries waiting to be run, one after another in text
+*/
+struct pending {
+    char *text;
+    size_t len;
+    size_t cap;
+    size_t *start; // of each query in text
+    unsigned *line;
+    unsigned n;
+};
+
+#define PENDING_DEFAULTS (struct pending) {\
+        .text = NULL,\
+        .len = 0,\
+        .cap = 0,\
+        .start = NULL,\
+        .line = NULL,\
+        .n = 0\
+    }
+
+/**
+ * One thread's share of the pending queries, first up to end
+*/
+struct worker {
+    struct scomplex *scomplex;
+    struct pending *pending;
+    unsigned first;
+    unsigned end;
+    struct scratch scratch;
+    struct output out;
+};
+
+static int add_pending(struct pending *pending, const char *cmd,
+                       const unsigned line) {
+    if(!pending->start) {
+        pending->start = malloc(BLOCK * sizeof(size_t));
+        pending->line = malloc(BLOCK * sizeof(unsigned));
+        if(!pending->start || !pending->line) return 1;
+    }
+
+    const size_t len = strlen(cmd) + 1;
+    if(pending->len + len > pending->cap) {
+        size_t cap = pending->cap ? pending->cap : 1 << 20;
+        while(cap < pending->len + len) cap *= 2;
+        char *tmp = realloc(pending->text, cap);
+        if(!tmp) return 1;
+        pending->text = tmp;
+        pending->cap = cap;
+    }
+    memcpy(pending->text + pending->len, cmd, len);
+    pending->start[pending->n] = pending->len;
+    pending->line[pending->n++] = line;
+    pending->len += len;
+    return 0;
+}
+
+static void *run_share(void *arg) {
+    struct worker *w = arg;
+    for(unsigned i = w->first; i < w->end; i++) {
+        begin_result(&w->out, w->pending->line[i]);
+        do_query(w->scomplex, &w->scratch,
+                 w->pending->text + w->pending->start[i], &w->out);
+        end_result(&w->out);
+    }
+    merge_stats();
+    return NULL;
+}
+
+/**
+ * Runs the pending queries, split into one contiguous share per
+ * thread, and writes their results to out in order. Returns 1 if
+ * malloc fails.
+*/
+static int run_pending(struct scomplex *scomplex, struct pending *pending,
+                       struct worker *workers, const int nthreads,
+                       struct output *out) {
+    const unsigned n = pending->n;
+    if(!n) return 0;
+    if(index_ids(scomplex) || find_components(scomplex)) return 1;
+
+    int nworkers = (n + MIN_SHARE - 1) / MIN_SHARE;
+    if(nworkers > nthreads) nworkers = nthreads;
+    for(int i = 0; i < nworkers; i++) {
+        struct worker *w = &workers[i];
+        w->scomplex = scomplex;
+        w->pending = pending;
+        w->first = (unsigned)((unsigned long long)n * i / nworkers);
+        w->end = (unsigned)((unsigned long long)n * (i + 1) / nworkers);
+        w->out.format = out->format;
+        if(reserve_scratch(&w->scratch, scomplex->nsimplices)) {
+            fprintf(stderr, "Malloc failed in run_pending\n");
+            return 1;
+        }
+    }
+    run_threads(nworkers, run_share, workers, sizeof(struct worker));
+
+    for(int i = 0; i < nworkers; i++) {
+        out_write(out, workers[i].out.buf, workers[i].out.len);
+        workers[i].out.len = 0;
+        flush_output(out, 0);
+    }
+    pending->n = 0;
+    pending->len = 0;
+    return 0;
+}
+
+/**
+ * Runs every command in the file at path ("-" for stdin), with no
+ * prompts in between, and writes the results to stdout in format.
+ * Blank lines and lines beginning with '#' are skipped. Queries in
+ * a row (see is_query()) are run on nthreads threads, and their
+ * results come out in the same order. How fast it went goes to
+ * stderr. Returns 1 if path can't be read, stdout can't be written
+ * or malloc fails.
+*/
+int run_batch(struct scomplex *scomplex, const char *path,
+              const enum output_format format, const int nthreads) {
+    FILE *script = strcmp(path, "-") ? fopen(path, "r") : stdin;
+    if(!script) {
+        fprintf(stderr, "Failed to open '%s'\n", path);
+        return 1;
+    }
+
+    struct output out = OUTPUT_DEFAULTS;
+    out.file = stdout;
+    out.format = format;
+    struct pending pending = PENDING_DEFAULTS;
+    struct worker *workers = calloc(nthreads, sizeof(struct worker));
+    if(!workers) {
+        fprintf(stderr, "Malloc failed in run_batch\n");
+        if(script != stdin) fclose(script);
+        return 1;
+    }
+    for(int i = 0; i < nthreads; i++) {
+        workers[i].scratch = SCRATCH_DEFAULTS;
+        workers[i].out = OUTPUT_DEFAULTS;
+    }
+
+    char *line = NULL;
+    size_t cap = 0;
+    unsigned lineno = 0, ncommands = 0;
+    int ret = 0;
+    const double start = stats_clock();
+    while(!ret && getline(&line, &cap, script) != -1) {
+        lineno++;
+        const char *pos = line + strspn(line, " \t\r\n");
+        if(!*pos || *pos == '#') continue;
+        ncommands++;
+
+        if(nthreads > 1 && is_query(line)) {
+            if(add_pending(&pending, line, lineno)) {
+                fprintf(stderr, "Malloc failed in run_batch\n");
+                ret = 1;
+            } else if(pending.n == BLOCK) {
+                ret = run_pending(scomplex, &pending, workers, nthreads,
+                                  &out);
+            }
+            continue;
+        }
+
+        ret = run_pending(scomplex, &pending, workers, nthreads, &out);
+        begin_result(&out, lineno);
+        do_command(scomplex, line, &out);
+        end_result(&out);
+        if(flush_output(&out, 0)) {
+            fprintf(stderr, "Failed to write the results\n");
+            ret = 1;
+        }
+    }
+    if(!ret) ret = run_pending(scomplex, &pending, workers, nthreads, &out);
+    if(flush_output(&out, 1)) {
+        fprintf(stderr, "Failed to write the results\n");
+        ret = 1;
+    }
+    const double elapsed = stats_clock() - start;
+
+    if(ferror(script)) {
+        fprintf(stderr, "Failed to read '%s'\n", path);
+        ret = 1;
+    }
+    fprintf(stderr, "%u commands in %.3f seconds (%.0f per second)\n",
+            ncommands, elapsed, elapsed > 0 ? ncommands / elapsed : 0);
+
+    for(int i = 0; i < nthreads; i++) {
+        free_scratch(&workers[i].scratch);
+        free_output(&workers[i].out);
+    }
+    free(workers);
+    free(pending.text);
+    free(pending.start);
+    free(pending.line);
+    free(line);
+    free_output(&out);
+    if(script != stdin) fclose(script);
+    return ret;
+}